@@ -5,6 +5,7 @@
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 
 // Add this before the namespace declaration
 #define LOG(message, level) Logger::log(message, __func__, level)
@@ -37,8 +38,11 @@ public:
     explicit ProgressBar(size_t total, size_t width = 70);
     void update(size_t current);
     void finish();
+    // Progress bars are disabled when several files are processed concurrently
+    static void setEnabled(bool enabled);
 
 private:
+    static bool enabled_;
     size_t total_;
     size_t width_;
     size_t last_printed_percent_;
@@ -53,11 +57,21 @@ public:
                    LogLevel level = LogLevel::INFO);
     static void setLogFile(const std::string& path);
     static void setVerbose(bool verbose);
+    // Messages below this level are dropped (default: DEBUG)
+    static void setMinLevel(LogLevel level);
+    // Batch workers collect their lines and write them once per file
+    static void beginBuffering();
+    static void flushBuffer();
 
 private:
     static std::ofstream logFile_;
     static bool initialized_;
     static bool verbose_;
+    static LogLevel minLevel_;
+    static thread_local bool buffering_;
+    static thread_local std::string fileBuffer_;
+    static thread_local std::string consoleBuffer_;
+    static std::mutex mutex_;  // serializes writes from worker threads
     static std::string getTimestamp();
     static std::string getLevelString(LogLevel level);
     static std::string getColoredLevel(LogLevel level);
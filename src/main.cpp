@@ -12,25 +12,93 @@
 #include <utility>
 #include <set>
 #include <regex>
+#include <cmath>
+#include <climits>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
 #include "utils.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 using json = nlohmann::json;
+namespace fs = std::filesystem;
 using namespace pinrex;
 
 const string APP_VERSION = "1.2.2";
 const string JSON_EXTENSION = ".json";
 const size_t JSON_EXTENSION_LENGTH = JSON_EXTENSION.length();
 const string ANY_DIGIT_REGEX = "[0-9]";
+const int POSTAL_CODE_LENGTH = 6;
 
+const string JSONL_EXTENSION = ".jsonl";
+const string BATCH_SUMMARY_FILE = "pinrex-summary.jsonl";
+const size_t MAX_POOLED_NODES = 1 << 16; // per thread, larger trees return the surplus to the allocator
 
-class Node{
+// per-thread free list for tree nodes, so batch workers reuse warm memory across files
+class NodePool{
+    public:
+        ~NodePool(){
+            for(void* block : freeBlocks){
+                ::operator delete(block);
+            }
+        }
+
+        void* allocate(size_t size){
+            if(freeBlocks.empty()){
+                return ::operator new(size);
+            }
+            void* block = freeBlocks.back();
+            freeBlocks.pop_back();
+            return block;
+        }
+
+        // must not throw, it backs Node's operator delete
+        void release(void* block) noexcept{
+            if(freeBlocks.size() >= MAX_POOLED_NODES){
+                ::operator delete(block);
+                return;
+            }
+            try{
+                freeBlocks.push_back(block);
+            }
+            catch(...){
+                ::operator delete(block);
+            }
+        }
+
+    private:
+        vector<void*> freeBlocks;
+};
+
+thread_local NodePool nodePool;
+
+// final: pooled blocks are recycled as sizeof(Node), a larger derived object must never reach the pool
+class Node final{
     public:
         int height;
         int childCount;
+        bool wildcard; // matches every suffix below this node (approximate mode)
+        size_t emittedLength; // length of the patterns last emitted for this subtree, digit prefixes included
         array<unique_ptr<Node>,10> children;
 
-        Node(int h) : height(h), childCount(0), children{} {}
+        Node(int h) : height(h), childCount(0), wildcard(false), emittedLength(0), children{} {}
+
+        static void* operator new(size_t size){
+            if(size != sizeof(Node)){
+                return ::operator new(size);
+            }
+            return nodePool.allocate(size);
+        }
+
+        static void operator delete(void* block, size_t size) noexcept{
+            if(size != sizeof(Node)){
+                ::operator delete(block);
+                return;
+            }
+            nodePool.release(block);
+        }
 
         void addChild(int index, unique_ptr<Node> child){
             if(index >= 0 && index < 10){
@@ -41,18 +109,27 @@ class Node{
                 throw invalid_argument("Index out of bounds");
             }
         }
+
+        // collapse the subtree so that it matches every possible suffix
+        void widen(){
+            for(auto& child : children){
+                child.reset();
+            }
+            childCount = 0;
+            wildcard = true;
+        }
 };
 
 // build a tree from a list of postal codes
-Node* buildTreeFromPostalCodes(const vector<string>& postalCodes){
+unique_ptr<Node> buildTreeFromPostalCodes(const vector<string>& postalCodes){
     Logger::log("Starting tree construction from postal codes", "buildTreeFromPostalCodes", LogLevel::DEBUG);
-    Node* root = new Node(0);
+    unique_ptr<Node> root(new Node(0));
     ProgressBar progress(postalCodes.size());
     
     for(size_t i = 0; i < postalCodes.size(); ++i) {
         const auto& postalCode = postalCodes[i];
         try {
-            Node* currentNode = root;
+            Node* currentNode = root.get();
             for(const char& digit : postalCode) {
                 int index = digit - '0';
                 if(index >= 0 && index < 10) {
@@ -80,6 +157,17 @@ Node* buildTreeFromPostalCodes(const vector<string>& postalCodes){
     return root;
 }
 
+// regex matching any sequence of the given number of digits
+string anyDigitsRegex(int count){
+    if(count <= 0){
+        return "";
+    }
+    else if(count == 1){
+        return ANY_DIGIT_REGEX;
+    }
+    return ANY_DIGIT_REGEX + "{" + to_string(count) + "}";
+}
+
 vector<string> getMissingDigits(const vector<string>& vec) {
     Logger::log("Calculating missing digits", "getMissingDigits", LogLevel::DEBUG);
     vector<string> result;
@@ -240,15 +328,21 @@ vector<string> groupAndTruncateRegexes(vector<string>& regexes,int height,int li
 // parse the tree to build a regex
 // should return an array of regexes
 vector<string> buildRegexFromTree(Node* root,int limit){
-    Logger::log("Building regex patterns from tree with limit: " + to_string(limit), "buildRegexFromTree", LogLevel::INFO);
+    Logger::log("Building regex patterns from tree with limit: " + to_string(limit), "buildRegexFromTree", LogLevel::DEBUG);
     vector<string> result;
     if(root->childCount == 0){
         return {};
     }
+    vector<string> wildcardDigits;
     for(int i = 0;i < 10;i++){
         if(root->children[i]){ // check if unique_ptr is not null
             vector<string> aux;
             Node* childNode = root->children[i].get();
+            if(childNode->wildcard){
+                // widened siblings share the same suffix, merge them into one class below
+                wildcardDigits.push_back(to_string(i));
+                continue;
+            }
             vector<string> subRegexes = buildRegexFromTree(childNode,limit);
             // before prefixing the regexes with the digit, we need to group
             if(subRegexes.size() == 0){
@@ -269,13 +363,167 @@ vector<string> buildRegexFromTree(Node* root,int limit){
             result = mergeSortedVectors(result,aux);
         }
     }
+    if(!wildcardDigits.empty()){
+        string digitClass = wildcardDigits.size() == 1 ? wildcardDigits[0] : truncateRegexForLeafNodes(wildcardDigits);
+        string wildcardRegex = digitClass + anyDigitsRegex(POSTAL_CODE_LENGTH - root->height - 1);
+        if(root->height == 0){
+            wildcardRegex = "^" + wildcardRegex;
+        }
+        result = mergeSortedVectors(result,{wildcardRegex});
+    }
     // need to trucate the regex
     vector<string> groupedRegexes = groupAndTruncateRegexes(result,root->height,limit);
-    Logger::log("Completed building regex patterns", "buildRegexFromTree", LogLevel::INFO);
+    // remembered so approximate mode can tell how much widening this subtree saves
+    root->emittedLength = groupedRegexes.size();
+    for(const auto& groupedRegex : groupedRegexes){
+        root->emittedLength += groupedRegex.size();
+    }
+    Logger::log("Completed building regex patterns", "buildRegexFromTree", LogLevel::DEBUG);
     return groupedRegexes;
 }
 
 
+// number of codes a fully populated subtree rooted at the given height matches
+long long subtreeCapacity(int height){
+    long long capacity = 1;
+    for(int h = height; h < POSTAL_CODE_LENGTH; h++){
+        capacity *= 10;
+    }
+    return capacity;
+}
+
+// number of codes matched by the subtree, counting widened nodes as full
+long long countCodes(const Node* node){
+    if(node->wildcard){
+        return subtreeCapacity(node->height);
+    }
+    if(node->childCount == 0){
+        return 1;
+    }
+    long long count = 0;
+    for(const auto& child : node->children){
+        if(child){
+            count += countCodes(child.get());
+        }
+    }
+    return count;
+}
+
+// pattern characters saved by widening the node, from its last emitted patterns
+long long wideningGain(const Node* node){
+    long long widenedLength = 1 + anyDigitsRegex(POSTAL_CODE_LENGTH - node->height).size();
+    return static_cast<long long>(node->emittedLength) - widenedLength;
+}
+
+struct WideningCandidate{
+    Node* node;
+    string prefix;
+    long long cost; // false positives introduced by widening the node
+    long long gain; // pattern characters saved by widening the node
+};
+
+void collectWideningCandidates(Node* node, const string& prefix, vector<WideningCandidate>& candidates){
+    for(int i = 0;i < 10;i++){
+        Node* child = node->children[i].get();
+        if(!child || child->childCount == 0){
+            continue;
+        }
+        string childPrefix = prefix + to_string(i);
+        long long cost = subtreeCapacity(child->height) - countCodes(child);
+        long long gain = wideningGain(child);
+        // already complete subtrees (cost 0) collapse for free
+        if(gain > 0){
+            candidates.push_back({child, childPrefix, cost, gain});
+        }
+        collectWideningCandidates(child, childPrefix, candidates);
+    }
+}
+
+// whether the (possibly widened) tree still matches the code
+bool treeMatchesCode(const Node* root, const string& code){
+    const Node* node = root;
+    for(const char& digit : code){
+        if(node->wildcard){
+            return true;
+        }
+        node = node->children[digit - '0'].get();
+        if(!node){
+            return false;
+        }
+    }
+    return node->wildcard || node->childCount == 0;
+}
+
+bool hasWidenedAncestor(const set<string>& widenedPrefixes, const string& prefix){
+    for(size_t length = 1; length < prefix.size(); length++){
+        if(widenedPrefixes.count(prefix.substr(0, length))){
+            return true;
+        }
+    }
+    return false;
+}
+
+// greedily widen subtrees into wildcards, free collapses first and then the best pattern savings
+// per false positive, without exceeding the false positive budget; returns the false positives introduced
+long long widenTreeWithinBudget(Node* root, const vector<string>& postalCodes, long long maxFalsePositives, int limit){
+    Logger::log("Widening tree with false positive budget: " + to_string(maxFalsePositives), "widenTreeWithinBudget", LogLevel::INFO);
+    // render once so every node knows the length of its emitted patterns
+    buildRegexFromTree(root, limit);
+    vector<WideningCandidate> candidates;
+    collectWideningCandidates(root, "", candidates);
+    stable_sort(candidates.begin(), candidates.end(), [](const WideningCandidate& a, const WideningCandidate& b){
+        if((a.cost == 0) != (b.cost == 0)){
+            return a.cost == 0;
+        }
+        // compare gain/cost ratios without division, prefer the larger gain on ties
+        long long lhs = a.gain * b.cost;
+        long long rhs = b.gain * a.cost;
+        return lhs != rhs ? lhs > rhs : a.gain > b.gain;
+    });
+
+    long long introduced = 0;
+    set<string> widenedPrefixes;
+    for(const auto& candidate : candidates){
+        // skip nodes that were freed by widening one of their ancestors
+        if(hasWidenedAncestor(widenedPrefixes, candidate.prefix)){
+            continue;
+        }
+        // descendants may already have been widened, so the live cost and gain can be lower
+        long long cost = subtreeCapacity(candidate.node->height) - countCodes(candidate.node);
+        if(introduced + cost > maxFalsePositives){
+            continue;
+        }
+        auto descendant = widenedPrefixes.lower_bound(candidate.prefix);
+        if(descendant != widenedPrefixes.end() && descendant->compare(0, candidate.prefix.size(), candidate.prefix) == 0){
+            buildRegexFromTree(candidate.node, limit);
+            if(wideningGain(candidate.node) <= 0){
+                continue;
+            }
+        }
+        candidate.node->widen();
+        widenedPrefixes.insert(candidate.prefix);
+        introduced += cost;
+    }
+    // a widened node may have been absorbed by a later widened ancestor, only count the survivors
+    size_t widenedSubtrees = 0;
+    for(const auto& prefix : widenedPrefixes){
+        if(!hasWidenedAncestor(widenedPrefixes, prefix)){
+            widenedSubtrees++;
+        }
+    }
+    Logger::log("Widened " + to_string(widenedSubtrees) + " subtrees, false positives introduced: " + to_string(introduced), "widenTreeWithinBudget", LogLevel::INFO);
+
+    // widening may only add matches, an input code that no longer matches is a bug
+    for(const auto& postalCode : postalCodes){
+        if(!treeMatchesCode(root, postalCode)){
+            string error = "Widened tree no longer matches postal code: " + postalCode;
+            Logger::log(error, "widenTreeWithinBudget", LogLevel::ERROR);
+            throw runtime_error(error);
+        }
+    }
+    return introduced;
+}
+
 // check if the file is a json file by checking the extension
 bool isJsonFile(const string& filePath){
     Logger::log("Checking if file is JSON: " + filePath, "isJsonFile", LogLevel::DEBUG);
@@ -294,7 +542,9 @@ json createJSONRegex(const vector<string>& regexes){
     return result;
 }
 
-bool validateRegexMatches(const vector<string>& regexes, const vector<int>& postalCodes) {
+// falsePositiveCount, when given, receives the exact number of non-input codes matched
+bool validateRegexMatches(const vector<string>& regexes, const vector<int>& postalCodes, long long maxFalsePositives = 0,
+                          long long* falsePositiveCount = nullptr) {
     LOG("Starting regex validation", LogLevel::INFO);
     try {
         set<int> validPostalCodes(postalCodes.begin(), postalCodes.end());
@@ -342,9 +592,12 @@ bool validateRegexMatches(const vector<string>& regexes, const vector<int>& post
         progress.finish();
 
         LOG("Validation complete. Total matches: " + to_string(totalMatches), LogLevel::INFO);
-        LOG("Invalid matches: " + to_string(invalidMatches.size()), LogLevel::INFO);
+        LOG("False positives: " + to_string(invalidMatches.size()) + " (budget: " + to_string(maxFalsePositives) + ")", LogLevel::INFO);
+        if (falsePositiveCount) {
+            *falsePositiveCount = invalidMatches.size();
+        }
 
-        if (!invalidMatches.empty()) {
+        if (static_cast<long long>(invalidMatches.size()) > maxFalsePositives) {
             string invalidSamples;
             int count = 0;
             for (int num : invalidMatches) {
@@ -356,21 +609,381 @@ bool validateRegexMatches(const vector<string>& regexes, const vector<int>& post
             return false;
         }
 
-        return totalMatches == validPostalCodes.size();
+        // false positives within the budget are allowed, but every valid code must still match
+        return totalMatches - invalidMatches.size() == validPostalCodes.size();
     } catch (const exception& e) {
         LOG("Validation error: " + string(e.what()), LogLevel::ERROR);
         return false;
     }
 }
 
+// write to a temporary file next to the target and rename it into place,
+// so readers never observe a partially written output
+bool writeFileAtomically(const string& filePath, const string& content){
+    // unique per call, concurrent writers never share a temporary file
+    static atomic<unsigned long long> tempCounter(0);
+    const string tempPath = filePath + ".tmp." + to_string(tempCounter++);
+    ofstream tempFile(tempPath);
+    if(!tempFile.is_open()){
+        return false;
+    }
+    tempFile << content;
+    tempFile.close();
+    error_code ec;
+    if(!tempFile.good() || (fs::rename(tempPath, filePath, ec), ec)){
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+struct RunOptions{
+    int regexLengthLimit = 1000;
+    bool verifyMode = false;
+    long long maxFalsePositives = -1; // -1 -> exact mode
+    double falsePositiveRate = -1.0;  // -1 -> exact mode
+};
+
+struct FileResult{
+    string inputFilePath;
+    string outputFilePath;
+    string status = "failed"; // ok, valid, invalid or failed
+    size_t regexCount = 0;
+    size_t regexLength = 0;
+    long long falsePositives = 0;
+    long long falsePositiveBudget = -1; // -1 -> exact mode
+    long long milliseconds = 0;
+    string error;
+};
+
+json createJSONSummary(const FileResult& result){
+    json summary;
+    summary["input"] = result.inputFilePath;
+    summary["output"] = result.outputFilePath;
+    summary["status"] = result.status;
+    summary["regexCount"] = result.regexCount;
+    summary["regexLength"] = result.regexLength;
+    summary["falsePositives"] = result.falsePositives;
+    if(result.falsePositiveBudget >= 0){
+        summary["falsePositiveBudget"] = result.falsePositiveBudget;
+    }
+    summary["milliseconds"] = result.milliseconds;
+    if(!result.error.empty()){
+        summary["error"] = result.error;
+    }
+    return summary;
+}
+
+// generate (or verify) the regexes for a single input file
+bool processPostalCodeFile(const RunOptions& options, FileResult& result){
+    const string& inputFilePath = result.inputFilePath;
+    const string& outputFilePath = result.outputFilePath;
+    auto fail = [&result](const string& error){
+        LOG(error, LogLevel::ERROR);
+        result.status = "failed";
+        result.error = error;
+        return false;
+    };
+
+    // Input file validation and reading
+    LOG("Validating input file: " + inputFilePath, LogLevel::INFO);
+    if(!isJsonFile(inputFilePath)) {
+        return fail("Invalid input file format: " + inputFilePath);
+    }
+
+    ifstream inputFile(inputFilePath);
+    if(!inputFile.is_open()) {
+        return fail("Failed to open input file: " + inputFilePath);
+    }
+
+    // Parse JSON
+    try {
+        LOG("Parsing input JSON file", LogLevel::INFO);
+        json postalCodesJson = json::parse(inputFile);
+
+        if(!postalCodesJson.is_object() || !postalCodesJson.contains("postalCodes") ||
+           !postalCodesJson["postalCodes"].is_array()) {
+            return fail("Invalid JSON structure: " + inputFilePath);
+        }
+
+        vector<string> postalCodes;
+        for (const auto& code : postalCodesJson["postalCodes"]) {
+            postalCodes.push_back(to_string(code.get<int>()));
+        }
+        LOG("Successfully parsed " + to_string(postalCodes.size()) + " postal codes", LogLevel::INFO);
+
+        // resolve the false positive budget, the tighter one wins when both are given
+        long long falsePositiveBudget = options.maxFalsePositives;
+        if (options.falsePositiveRate >= 0) {
+            // clamp before casting, a huge rate would overflow long long
+            double scaledBudget = options.falsePositiveRate * postalCodes.size();
+            long long rateBudget = scaledBudget >= static_cast<double>(LLONG_MAX) ? LLONG_MAX : static_cast<long long>(scaledBudget);
+            falsePositiveBudget = falsePositiveBudget < 0 ? rateBudget : min(falsePositiveBudget, rateBudget);
+        }
+        bool approximateMode = falsePositiveBudget >= 0;
+        // widening counts capacities in POSTAL_CODE_LENGTH digits, other lengths stay exact
+        if (approximateMode) {
+            for (const auto& postalCode : postalCodes) {
+                if (postalCode.size() != static_cast<size_t>(POSTAL_CODE_LENGTH)) {
+                    LOG("Postal code " + postalCode + " is not " + to_string(POSTAL_CODE_LENGTH) +
+                        " digits long, falling back to exact mode", LogLevel::WARNING);
+                    approximateMode = false;
+                    break;
+                }
+            }
+        }
+
+        if (approximateMode) {
+            result.falsePositiveBudget = falsePositiveBudget;
+        }
+
+        if (options.verifyMode) {
+            LOG("Starting verification mode", LogLevel::INFO);
+            try {
+                ifstream outputFile(outputFilePath);
+                if (!outputFile.is_open()) {
+                    return fail("Failed to open output file for verification: " + outputFilePath);
+                }
+                json outputJson = json::parse(outputFile);
+                vector<string> regexes = outputJson["regexes"];
+                result.regexCount = regexes.size();
+                for (const auto& regex : regexes) {
+                    result.regexLength += regex.size();
+                }
+                bool isValid = validateRegexMatches(regexes, postalCodesJson["postalCodes"], approximateMode ? falsePositiveBudget : 0,
+                                                    &result.falsePositives);
+                LOG("Verification completed. Result: " + string(isValid ? "valid" : "invalid"), LogLevel::INFO);
+                result.status = isValid ? "valid" : "invalid";
+                return isValid;
+            } catch (const exception& e) {
+                return fail("Verification error: " + string(e.what()));
+            }
+        }
+
+        // Build regex tree and patterns
+        LOG("Building regex tree", LogLevel::INFO);
+        unique_ptr<Node> root = buildTreeFromPostalCodes(postalCodes);
+        if (approximateMode) {
+            result.falsePositives = widenTreeWithinBudget(root.get(), postalCodes, falsePositiveBudget, options.regexLengthLimit);
+            LOG("Approximate mode: " + to_string(result.falsePositives) + " false positives introduced", LogLevel::INFO);
+        }
+        vector<string> regexes = buildRegexFromTree(root.get(), options.regexLengthLimit);
+        result.regexCount = regexes.size();
+        for (const auto& regex : regexes) {
+            result.regexLength += regex.size();
+        }
+
+        // Write output
+        LOG("Writing regex patterns to output file", LogLevel::INFO);
+        json jsonRegexes = createJSONRegex(regexes);
+        if(!writeFileAtomically(outputFilePath, jsonRegexes.dump(4))) {
+            return fail("Failed to write output file: " + outputFilePath);
+        }
+        LOG("Successfully wrote regex patterns to: " + outputFilePath, LogLevel::INFO);
+        result.status = "ok";
+        return true;
+
+    } catch (const exception& e) {
+        return fail("Fatal error: " + string(e.what()));
+    }
+}
+
+// match a file name against a pattern with * and ? wildcards
+bool matchesWildcard(const string& name, const string& pattern){
+    size_t n = 0, p = 0;
+    size_t starPattern = string::npos, starName = 0;
+    while(n < name.size()){
+        if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])){
+            n++;
+            p++;
+        }
+        else if(p < pattern.size() && pattern[p] == '*'){
+            starPattern = p++;
+            starName = n;
+        }
+        else if(starPattern != string::npos){
+            p = starPattern + 1;
+            n = ++starName;
+        }
+        else{
+            return false;
+        }
+    }
+    while(p < pattern.size() && pattern[p] == '*'){
+        p++;
+    }
+    return p == pattern.size();
+}
+
+string batchSummaryPath(const string& outputDirectory){
+    return (fs::path(outputDirectory.empty() ? "." : outputDirectory) / BATCH_SUMMARY_FILE).string();
+}
+
+// refuse jobs that would overwrite an input, another job's output or the summary
+void checkBatchOutputs(const vector<FileResult>& jobs, const string& summaryPath){
+    auto normalized = [](const string& path){
+        return fs::weakly_canonical(fs::absolute(path)).string();
+    };
+    set<string> inputs;
+    for(const auto& job : jobs){
+        inputs.insert(normalized(job.inputFilePath));
+    }
+    set<string> outputs = {normalized(summaryPath)};
+    if(inputs.count(*outputs.begin())){
+        throw invalid_argument("Batch summary would overwrite an input: " + summaryPath);
+    }
+    for(const auto& job : jobs){
+        const string output = normalized(job.outputFilePath);
+        if(inputs.count(output)){
+            throw invalid_argument("Output would overwrite an input: " + job.outputFilePath);
+        }
+        if(!outputs.insert(output).second){
+            throw invalid_argument("Output path used more than once: " + job.outputFilePath);
+        }
+    }
+}
+
+// expand a batch manifest (directory, glob or JSONL file) into input/output pairs
+vector<FileResult> collectBatchJobs(const string& manifest, const string& outputDirectory){
+    LOG("Collecting batch jobs from: " + manifest, LogLevel::INFO);
+    vector<FileResult> jobs;
+    auto addJob = [&jobs, &outputDirectory](const fs::path& input, const string& output){
+        FileResult job;
+        job.inputFilePath = input.string();
+        if(!output.empty()){
+            job.outputFilePath = output;
+        }
+        else if(!outputDirectory.empty()){
+            job.outputFilePath = (fs::path(outputDirectory) / input.filename()).string();
+        }
+        else{
+            throw invalid_argument("No output path for " + input.string() + ", pass -o <output-directory>");
+        }
+        jobs.push_back(job);
+    };
+
+    const fs::path manifestPath(manifest);
+    if(fs::is_directory(manifestPath) || manifest.find_first_of("*?") != string::npos){
+        // every JSON file in the directory, or every file matching the glob's file name
+        fs::path directory = manifestPath;
+        string pattern = "*" + JSON_EXTENSION;
+        if(!fs::is_directory(manifestPath)){
+            directory = manifestPath.has_parent_path() ? manifestPath.parent_path() : fs::path(".");
+            pattern = manifestPath.filename().string();
+        }
+        vector<fs::path> inputs;
+        for(const auto& entry : fs::directory_iterator(directory)){
+            if(entry.is_regular_file() && matchesWildcard(entry.path().filename().string(), pattern)){
+                inputs.push_back(entry.path());
+            }
+        }
+        sort(inputs.begin(), inputs.end());
+        for(const auto& input : inputs){
+            addJob(input, "");
+        }
+    }
+    else if(manifestPath.extension() == JSONL_EXTENSION){
+        // one {"input": ..., "output": ...} object per line, paths relative to the manifest
+        ifstream manifestFile(manifest);
+        if(!manifestFile.is_open()){
+            throw runtime_error("Failed to open batch manifest: " + manifest);
+        }
+        const fs::path baseDirectory = manifestPath.parent_path();
+        string line;
+        size_t lineNumber = 0;
+        while(getline(manifestFile, line)){
+            lineNumber++;
+            if(line.find_first_not_of(" \t\r") == string::npos){
+                continue;
+            }
+            json entry = json::parse(line);
+            if(!entry.is_object() || !entry.contains("input") || !entry["input"].is_string()){
+                throw runtime_error("Invalid manifest entry on line " + to_string(lineNumber));
+            }
+            string output;
+            if(entry.contains("output")){
+                output = (baseDirectory / entry["output"].get<string>()).string();
+            }
+            addJob(baseDirectory / entry["input"].get<string>(), output);
+        }
+    }
+    else{
+        throw invalid_argument("Batch manifest must be a directory, a glob or a " + JSONL_EXTENSION + " file: " + manifest);
+    }
+    checkBatchOutputs(jobs, batchSummaryPath(outputDirectory));
+    LOG("Collected " + to_string(jobs.size()) + " batch jobs", LogLevel::INFO);
+    return jobs;
+}
+
+// process every manifest entry in one process on a shared worker pool
+int runBatch(const string& manifest, const string& outputDirectory, const RunOptions& options, size_t threadCount){
+    vector<FileResult> jobs = collectBatchJobs(manifest, outputDirectory);
+    if(!outputDirectory.empty()){
+        fs::create_directories(outputDirectory);
+    }
+
+    // concurrent progress bars would interleave on the terminal, and per-node
+    // debug lines from every worker would serialize the batch on the log file
+    ProgressBar::setEnabled(false);
+    Logger::setMinLevel(LogLevel::INFO);
+    atomic<size_t> failures(0);
+    auto start = chrono::steady_clock::now();
+    {
+        ThreadPool pool(threadCount);
+        LOG("Processing " + to_string(jobs.size()) + " files on " + to_string(pool.size()) + " threads", LogLevel::INFO);
+        for(auto& job : jobs){
+            pool.submit([&job, &options, &failures](){
+                auto jobStart = chrono::steady_clock::now();
+                Logger::beginBuffering();
+                bool succeeded = false;
+                // one bad file must not take down the whole batch
+                try {
+                    succeeded = processPostalCodeFile(options, job);
+                } catch (const exception& e) {
+                    job.status = "failed";
+                    job.error = "Unexpected error: " + string(e.what());
+                    Logger::log(job.error + " while processing: " + job.inputFilePath, "runBatch", LogLevel::ERROR);
+                } catch (...) {
+                    job.status = "failed";
+                    job.error = "Unexpected error";
+                    Logger::log(job.error + " while processing: " + job.inputFilePath, "runBatch", LogLevel::ERROR);
+                }
+                Logger::flushBuffer();
+                if(!succeeded){
+                    failures++;
+                }
+                job.milliseconds = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - jobStart).count();
+            });
+        }
+        pool.wait();
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    // per-file summary, one JSON object per line in manifest order
+    string summary;
+    for(const auto& job : jobs){
+        summary += createJSONSummary(job).dump() + "\n";
+    }
+    const string summaryPath = batchSummaryPath(outputDirectory);
+    if(!writeFileAtomically(summaryPath, summary)){
+        LOG("Failed to write batch summary: " + summaryPath, LogLevel::ERROR);
+        return 1;
+    }
+    LOG("Batch completed in " + to_string(elapsed) + " ms, " + to_string(jobs.size() - failures) + " succeeded, " +
+        to_string(failures.load()) + " failed. Summary written to: " + summaryPath, LogLevel::INFO);
+    cout << "Processed " << jobs.size() << " files in " << elapsed << " ms: "
+         << jobs.size() - failures << " succeeded, " << failures << " failed (summary: " << summaryPath << ")" << endl;
+    return failures == 0 ? 0 : 1;
+}
+
 /*
 argc -> argument count
 argv -> argument vector
 */
 int main(int argc, char* argv[]) {
-    string inputFilePath, outputFilePath;
-    int regexLengthLimit = 1000;
-    bool verifyMode = false;
+    string inputFilePath, outputFilePath, batchManifest;
+    RunOptions options;
+    size_t threadCount = thread::hardware_concurrency();
     bool verboseMode = false;
 
     // Initialize logger
@@ -388,11 +1001,16 @@ int main(int argc, char* argv[]) {
             } else if (arg == "--help" || arg == "-h") {
                 LOG("Help request received", LogLevel::DEBUG);
                 cout << "Usage: " << argv[0] << " -i <input-file-path> -o <output-file-path> -l <regex-limit>" << "\n";
+                cout << "       " << argv[0] << " --batch <manifest> -o <output-directory> [-j <threads>]" << "\n";
                 cout << "Options:" << "\n";
                 cout << "  -i, --input <input-file-path>    Path to the input JSON file containing postal codes" << "\n";
                 cout << "  -o, --output <output-file-path>  Path to the output JSON file for generated regex patterns" << "\n";
                 cout << "  -l, --limit <regex-limit>        Maximum length of generated regex patterns (default: 1000)" << "\n";
                 cout << "  --verify                        Verify generated regex patterns against input postal codes" << "\n";
+                cout << "  --max-false-positives <count>   Allow up to <count> extra matching codes in exchange for shorter regexes" << "\n";
+                cout << "  --fp-rate <rate>                Allow extra matching codes up to <rate> times the number of input codes" << "\n";
+                cout << "  --batch <manifest>              Process a directory, a glob or a JSONL manifest of input files" << "\n";
+                cout << "  -j, --threads <threads>         Worker threads for batch mode (default: number of cores)" << "\n";
                 cout << "  --verbose                       Enable verbose output" << "\n";
                 cout << "  --version                       Display the version of PinRex" << "\n";
                 cout << "  --help                          Display this help message" << "\n";
@@ -404,10 +1022,32 @@ int main(int argc, char* argv[]) {
                 outputFilePath = argv[++i];
                 LOG("Output file set to: " + outputFilePath, LogLevel::DEBUG);
             } else if (arg == "-l" && i + 1 < argc) {
-                regexLengthLimit = stoi(argv[++i]);
-                LOG("Regex length limit set to: " + to_string(regexLengthLimit), LogLevel::DEBUG);
+                options.regexLengthLimit = stoi(argv[++i]);
+                LOG("Regex length limit set to: " + to_string(options.regexLengthLimit), LogLevel::DEBUG);
+            } else if (arg == "--max-false-positives" && i + 1 < argc) {
+                options.maxFalsePositives = stoll(argv[++i]);
+                if (options.maxFalsePositives < 0) {
+                    throw invalid_argument("--max-false-positives must be non-negative");
+                }
+                LOG("False positive budget set to: " + to_string(options.maxFalsePositives), LogLevel::DEBUG);
+            } else if (arg == "--fp-rate" && i + 1 < argc) {
+                options.falsePositiveRate = stod(argv[++i]);
+                if (!isfinite(options.falsePositiveRate) || options.falsePositiveRate < 0) {
+                    throw invalid_argument("--fp-rate must be a finite non-negative number");
+                }
+                LOG("False positive rate set to: " + to_string(options.falsePositiveRate), LogLevel::DEBUG);
+            } else if (arg == "--batch" && i + 1 < argc) {
+                batchManifest = argv[++i];
+                LOG("Batch manifest set to: " + batchManifest, LogLevel::DEBUG);
+            } else if ((arg == "-j" || arg == "--threads") && i + 1 < argc) {
+                int threads = stoi(argv[++i]);
+                if (threads <= 0) {
+                    throw invalid_argument("--threads must be positive");
+                }
+                threadCount = threads;
+                LOG("Thread count set to: " + to_string(threadCount), LogLevel::DEBUG);
             } else if (arg == "--verify") {
-                verifyMode = true;
+                options.verifyMode = true;
                 LOG("Verify mode enabled", LogLevel::DEBUG);
             } else if (arg == "--verbose") {
                 verboseMode = true;
@@ -426,77 +1066,31 @@ int main(int argc, char* argv[]) {
             LOG("Starting PinRex v" + APP_VERSION, LogLevel::INFO);
         }
 
-        // Input file validation and reading
-        LOG("Validating input file: " + inputFilePath, LogLevel::INFO);
-        if(!isJsonFile(inputFilePath)) {
-            LOG("Invalid input file format", LogLevel::ERROR);
-            return 1;
-        }
-
-        ifstream inputFile(inputFilePath);
-        if(!inputFile.is_open()) {
-            LOG("Failed to open input file: " + inputFilePath, LogLevel::ERROR);
-            return 1;
-        }
-
-        // Parse JSON
-        try {
-            LOG("Parsing input JSON file", LogLevel::INFO);
-            json postalCodesJson = json::parse(inputFile);
-            
-            if(!postalCodesJson.is_object() || !postalCodesJson.contains("postalCodes") || 
-               !postalCodesJson["postalCodes"].is_array()) {
-                LOG("Invalid JSON structure", LogLevel::ERROR);
-                return 1;
-            }
-
-            vector<string> postalCodes;
-            for (const auto& code : postalCodesJson["postalCodes"]) {
-                postalCodes.push_back(to_string(code.get<int>()));
-            }
-            LOG("Successfully parsed " + to_string(postalCodes.size()) + " postal codes", LogLevel::INFO);
-
-            if (verifyMode) {
-                LOG("Starting verification mode", LogLevel::INFO);
-                try {
-                    ifstream outputFile(outputFilePath);
-                    if (!outputFile.is_open()) {
-                        LOG("Failed to open output file for verification: " + outputFilePath, LogLevel::ERROR);
-                        return 1;
-                    }
-                    json outputJson = json::parse(outputFile);
-                    vector<string> regexes = outputJson["regexes"];
-                    bool isValid = validateRegexMatches(regexes, postalCodesJson["postalCodes"]);
-                    LOG("Verification completed. Result: " + string(isValid ? "valid" : "invalid"), LogLevel::INFO);
-                    return isValid ? 0 : 1;
-                } catch (const exception& e) {
-                    LOG("Verification error: " + string(e.what()), LogLevel::ERROR);
-                    return 1;
-                }
-            }
-
-            // Build regex tree and patterns
-            LOG("Building regex tree", LogLevel::INFO);
-            Node* root = buildTreeFromPostalCodes(postalCodes);
-            vector<string> regexes = buildRegexFromTree(root, regexLengthLimit);
-            
-            // Write output
-            LOG("Writing regex patterns to output file", LogLevel::INFO);
-            ofstream outputFile(outputFilePath);
-            if(outputFile.is_open()) {
-                json result = createJSONRegex(regexes);
-                outputFile << result.dump(4);
-                outputFile.close();
-                LOG("Successfully wrote regex patterns to: " + outputFilePath, LogLevel::INFO);
-            } else {
-                LOG("Failed to open output file for writing: " + outputFilePath, LogLevel::ERROR);
+        if (!batchManifest.empty()) {
+            try {
+                int status = runBatch(batchManifest, outputFilePath, options, threadCount);
+                LOG("PinRex batch finished", LogLevel::INFO);
+                return status;
+            } catch (const exception& e) {
+                LOG("Batch error: " + string(e.what()), LogLevel::ERROR);
                 return 1;
             }
+        }
 
-        } catch (const exception& e) {
-            LOG("Fatal error: " + string(e.what()), LogLevel::ERROR);
+        FileResult result;
+        result.inputFilePath = inputFilePath;
+        result.outputFilePath = outputFilePath;
+        bool succeeded = processPostalCodeFile(options, result);
+        if (options.verifyMode && result.status != "failed" && result.falsePositiveBudget >= 0) {
+            cout << "Verification " << result.status << ": " << result.falsePositives << " false positives (budget: "
+                 << result.falsePositiveBudget << ")" << endl;
+        }
+        if (!succeeded) {
             return 1;
         }
+        if (options.verifyMode) {
+            return 0;
+        }
 
     } catch(const exception& e) {
         LOG("Error parsing arguments: " + string(e.what()), LogLevel::ERROR);
@@ -505,4 +1099,4 @@ int main(int argc, char* argv[]) {
 
     LOG("PinRex completed successfully", LogLevel::INFO);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,99 @@
+#include "thread_pool.hpp"
+
+namespace pinrex {
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : nextQueue_(0), queued_(0), pending_(0), stopping_(false) {
+    if (threadCount == 0) threadCount = 1;  // hardware_concurrency() may return 0
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Spread submissions round-robin, stealing balances the rest
+    size_t index = nextQueue_++ % queues_.size();
+    pending_++;
+    {
+        // Count the task before it becomes visible so queued_ never underflows
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    taskAvailable_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    allDone_.wait(lock, [this] { return pending_ == 0; });
+}
+
+bool ThreadPool::popTask(size_t index, std::function<void()>& task) {
+    // Owner takes from the back of its own queue
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::stealTask(size_t index, std::function<void()>& task) {
+    // Thieves take from the front of the other queues
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& queue = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    while (true) {
+        std::function<void()> task;
+        if (popTask(index, task) || stealTask(index, task)) {
+            queued_--;
+            // Tasks report their own errors, an escaping exception must not kill the worker
+            try {
+                task();
+            } catch (...) {
+            }
+            if (--pending_ == 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                allDone_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        taskAvailable_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) return;
+    }
+}
+
+} // namespace pinrex
@@ -8,16 +8,24 @@ namespace pinrex {
 std::ofstream Logger::logFile_;
 bool Logger::initialized_ = false;
 bool Logger::verbose_ = false;  // Default to non-verbose
+std::mutex Logger::mutex_;
+LogLevel Logger::minLevel_ = LogLevel::DEBUG;
+thread_local bool Logger::buffering_ = false;
+thread_local std::string Logger::fileBuffer_;
+thread_local std::string Logger::consoleBuffer_;
+bool ProgressBar::enabled_ = true;
 
 // ProgressBar implementation
 ProgressBar::ProgressBar(size_t total, size_t width) 
     : total_(total), width_(width), last_printed_percent_(0) {
+    if (!enabled_) return;
     // Print initial empty progress bar
     std::cout << "[" << std::string(width_, ' ') << "] 0%\r";
     std::cout.flush();
 }
 
 void ProgressBar::update(size_t current) {
+    if (!enabled_) return;
     if (current > total_) current = total_;
     
     float progress = static_cast<float>(current) / total_;
@@ -40,10 +48,15 @@ void ProgressBar::update(size_t current) {
 }
 
 void ProgressBar::finish() {
+    if (!enabled_) return;
     update(total_);
     std::cout << std::endl;
 }
 
+void ProgressBar::setEnabled(bool enabled) {
+    enabled_ = enabled;
+}
+
 // Logger implementation
 void Logger::init(const std::string& logFile) {
     if (!initialized_) {
@@ -65,14 +78,46 @@ void Logger::setVerbose(bool verbose) {
     verbose_ = verbose;
 }
 
+void Logger::setMinLevel(LogLevel level) {
+    minLevel_ = level;
+}
+
+void Logger::beginBuffering() {
+    buffering_ = true;
+}
+
+void Logger::flushBuffer() {
+    buffering_ = false;
+    if (fileBuffer_.empty() && consoleBuffer_.empty()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!consoleBuffer_.empty()) {
+        std::cout << consoleBuffer_;
+        std::cout.flush();
+    }
+    if (logFile_.is_open() && !fileBuffer_.empty()) {
+        logFile_ << fileBuffer_;
+        logFile_.flush();
+    }
+    fileBuffer_.clear();
+    consoleBuffer_.clear();
+}
+
 std::string Logger::getTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
-    
+
+    // localtime() shares a static buffer, buffered batch logging runs this outside the lock
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
+    ss << std::put_time(&localTime, "%Y-%m-%d %H:%M:%S");
     ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
     return ss.str();
 }
@@ -99,6 +144,22 @@ std::string Logger::getColoredLevel(LogLevel level) {
 }
 
 void Logger::log(const std::string& message, const std::string& function_name, LogLevel level) {
+    if (level < minLevel_) return;
+
+    if (buffering_) {
+        std::string timestamp = getTimestamp();
+        if (verbose_) {
+            consoleBuffer_ += timestamp + " [" + getColoredLevel(level) + "] [" +
+                              Color::CYAN + function_name + Color::RESET + "] " + message + "\n";
+        }
+        if (logFile_.is_open()) {
+            fileBuffer_ += timestamp + " [" + getLevelString(level) + "] [" +
+                           function_name + "] " + message + "\n";
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
     // Only output to console if verbose mode is enabled
     if (verbose_) {
         std::string timestamp = getTimestamp();